@@ -0,0 +1,47 @@
+/************************************************************************
+ * picochroma - A digital lighting system built with Pi Pico
+ * lin.c
+ * PWM-to-flux linearization for the warm and cold LED drivers
+ ************************************************************************/
+
+#include "lin.h"
+
+lin_cal_t lin_cal[2] = {{LIN_DUTY_C, LIN_FLUX_C}, {LIN_DUTY_W, LIN_FLUX_W}};
+
+// build the linearization table lut[0..level_max], which converts a level that is linear
+// in flux to a duty cycle level, by inverting the piecewise-linear duty-to-flux curve
+// given by the calibration points.
+// returns false (and leaves the table unchanged) if the points are not increasing
+// from 0 to LIN_FULL
+bool
+lin_lut_build(const lin_cal_t *cal, uint16_t *lut, int level_max) {
+    uint64_t target, f0, f1, d0, d1;
+    int k, level;
+
+    if (cal->duty[0] != 0 || cal->duty[LIN_CAL_POINTS - 1] != LIN_FULL ||
+        cal->flux[0] != 0 || cal->flux[LIN_CAL_POINTS - 1] != LIN_FULL) {
+        return false;
+    }
+    for (k = 1; k < LIN_CAL_POINTS; k++) {
+        if (cal->duty[k] <= cal->duty[k - 1] || cal->flux[k] <= cal->flux[k - 1]) {
+            return false;
+        }
+    }
+
+    // duty, flux and level are all compared scaled up to level_max * LIN_FULL, to stay in integers
+    k = 0;
+    for (level = 0; level <= level_max; level++) {
+        target = (uint64_t) level * LIN_FULL;
+        while ((k < LIN_CAL_POINTS - 2) && ((uint64_t) cal->flux[k + 1] * level_max < target)) {
+            k++;
+        }
+        f0 = (uint64_t) cal->flux[k] * level_max;
+        f1 = (uint64_t) cal->flux[k + 1] * level_max;
+        d0 = (uint64_t) cal->duty[k] * level_max;
+        d1 = (uint64_t) cal->duty[k + 1] * level_max;
+        // interpolate, and round to the nearest level
+        lut[level] = ((d0 * (f1 - f0)) + ((d1 - d0) * (target - f0)) + (((f1 - f0) * LIN_FULL) / 2)) /
+                     ((f1 - f0) * LIN_FULL);
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+/************************************************************************
+ * picochroma - A digital lighting system built with Pi Pico
+ * lin.h
+ * PWM-to-flux linearization for the warm and cold LED drivers
+ ************************************************************************/
+
+#ifndef LIN_H
+#define LIN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Each calibration point is a duty cycle and the flux measured at that duty cycle,
+// both in per-mille of full duty (and of the flux at full duty).
+// The points are dense near zero and near full duty, where LED drivers are least linear.
+// The defaults below are for perfectly linear drivers (i.e. no correction).
+// The 'l' command can be used to enter new points, and prints out replacement definitions.
+#define LIN_CAL_POINTS 12
+#define LIN_FULL 1000
+#define LIN_DUTY_C {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 1000}
+#define LIN_FLUX_C {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 1000}
+#define LIN_DUTY_W {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 1000}
+#define LIN_FLUX_W {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 1000}
+
+typedef struct {
+    uint16_t duty[LIN_CAL_POINTS];
+    uint16_t flux[LIN_CAL_POINTS];
+} lin_cal_t;
+
+extern lin_cal_t lin_cal[2]; // indexed by LED type (cold, warm)
+
+bool lin_lut_build(const lin_cal_t *cal, uint16_t *lut, int level_max);
+
+#endif // LIN_H
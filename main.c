@@ -10,6 +10,12 @@
 #include "hardware/gpio.h"
 #include "pico/stdlib.h"
 #include "hardware/pwm.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "hardware/irq.h"
+#include "strip.pio.h"
+#include "lin.h"
 
 // ***************** defines ***************
 // Pico-Eurocard used GPIO22 for the LED.
@@ -34,6 +40,25 @@
 #define LED_TYPE_COLD 0
 #define LED_TYPE_WARM 1
 
+// addressable LED strip output (WS2812/SK6812 family), driven by PIO and DMA
+#define STRIP_PIN 2
+#define STRIP_NUM_PIXELS 300
+#define STRIP_FREQ 800000
+// bits per pixel: 24 for WW/CW (or RGB) strips, 32 for RGBW strips
+#define STRIP_BITS 24
+// bit position of the cold and warm channels in the pixel word, which is
+// sent MSB first. The first byte on the wire is at bit 24, the second at 16,
+// and so on. For an RGBW strip, white is the fourth byte (bit 0).
+#define STRIP_SHIFT_COLD 24
+#define STRIP_SHIFT_WARM 16
+// low time needed after a frame for the strip to latch the data
+#define STRIP_RESET_US 300
+// time for the PIO to send what is left in the (joined) TX FIFO and the OSR once DMA
+// has finished, i.e. up to 9 pixels, in microseconds
+#define STRIP_DRAIN_US ((9 * STRIP_BITS * 1000) / (STRIP_FREQ / 1000))
+// STRIP_K converts PWM level (0-PWM_MAX) to 8-bit pixel value in Q12, rounded up
+#define STRIP_K (((255 << 12) + PWM_MAX - 1) / PWM_MAX)
+
 // LED color-related definitions for Warm and Cold LEDs
 // (_W and _C respectively).
 // color temperatures
@@ -106,6 +131,8 @@
 // if encoder is too granular, increase these values
 #define MICROSTEP_MAX_INTENSITY 5
 #define MICROSTEP_MAX_COLOR 2
+// holding the button for this many debounce periods (about 1 second) toggles boost mode
+#define BOOST_HOLD_COUNT 5
 // misc
 #define FOREVER 1
 
@@ -170,7 +197,24 @@ int colmin, colmax; // min/max supported color temperatures (in hundreds of K)
 int pwm_store[2][2];
 int pwm_table_w[CCT_ARR_SIZE]; // PWM values for artifical max (i.e. un-boosted) brightnesses per color temperature
 int pwm_table_c[CCT_ARR_SIZE];
+int pwm_boost_w[CCT_ARR_SIZE]; // PWM values for the maximum achievable brightness per color temperature
+int pwm_boost_c[CCT_ARR_SIZE];
+volatile bool boost = false; // if true, the boost tables are used instead of the constant-brightness ones
+int hold_count = 0; // used to detect a long button press
+volatile bool calibrating = false; // set while calibrating, so that the encoder doesn't change the PWM
 int cct_tbl_min_div100; // stores the value of CCT[0]/100 (because it is used a lot)
+uint16_t lin_lut[2][PWM_MAX + 1]; // linear flux level to PWM level, built from lin_cal
+int bright_table_q8[10]; // BRIGHT_TABLE in fixed point (256 = 1.0) for the strip output
+// the strip framebuffer is double-buffered; pixels are drawn into strip_fb[strip_back]
+// while DMA streams the other buffer out to the PIO state machine
+uint32_t strip_fb[2][STRIP_NUM_PIXELS];
+int strip_back = 0;
+volatile bool strip_pending = false; // set when the back buffer has a new frame to show
+volatile bool strip_busy = false; // set while a frame is being sent and latched
+bool strip_gradient = false; // if true, the strip shows a gradient from colmin to colmax
+PIO strip_pio = pio0;
+uint strip_sm;
+int strip_dma_chan;
 
 
 // ********** functions *************************
@@ -246,7 +290,10 @@ display_digit(char idx, char val) {
     gpio_put(DIG_PIN[0], 0);
     gpio_put(DIG_PIN[1], 0);
     bm = DIG_BM[val];
-    for (i = 0; i < 7; i++) {
+    if (boost && idx == 1) { // decimal point on the right digit indicates boost mode
+        bm = bm | BM_DP;
+    }
+    for (i = 0; i < 8; i++) {
         if (bm & 0x01) {
             gpio_put(SEG_PIN[i], 1);
         } else {
@@ -267,22 +314,49 @@ bool seg_refresh_cb(struct repeating_timer *t) {
     return true;
 }
 
+// switch between intensity and color adjustment
+void toggle_appmode(void) {
+    if (appmode == MODE_INTENSITY) {
+        appmode = MODE_COLOR;
+        rotval = color;
+    } else {
+        appmode = MODE_INTENSITY;
+        rotval = intensity;
+    }
+    set_dispval(rotval, SUPPRESS_DIG_LEFT);
+}
+
 // handle button presses
 void button_handler(void) {
+    // the button interrupt is level-triggered, so it would keep firing while the button
+    // is held; it is re-enabled by do_debounce() once the button is released
+    gpio_set_irq_enabled(BUTTON_PIN, GPIO_IRQ_LEVEL_LOW, false);
     if (bmenu_state == BMENU_IDLE) {
-        if (appmode == MODE_INTENSITY) {
-            appmode = MODE_COLOR;
-            rotval = color;
-        } else {
-            appmode = MODE_INTENSITY;
-            rotval = intensity;
-        }
-        set_dispval(rotval, SUPPRESS_DIG_LEFT);
+        toggle_appmode();
         bmenu_state = BMENU_PRESSED;
         microstep = 0;
     }
 }
 
+// print out one set of calibration values as a definition
+void
+lin_cal_print_def(const char *name, const uint16_t *vals) {
+    int k;
+    printf("#define %s {", name);
+    for (k = 0; k < LIN_CAL_POINTS; k++) {
+        printf("%d%s", vals[k], (k < LIN_CAL_POINTS - 1) ? ", " : "}\n");
+    }
+}
+
+// print out the calibration points in a form that can be pasted into the definitions
+void
+lin_cal_print(void) {
+    lin_cal_print_def("LIN_DUTY_C", lin_cal[LED_TYPE_COLD].duty);
+    lin_cal_print_def("LIN_FLUX_C", lin_cal[LED_TYPE_COLD].flux);
+    lin_cal_print_def("LIN_DUTY_W", lin_cal[LED_TYPE_WARM].duty);
+    lin_cal_print_def("LIN_FLUX_W", lin_cal[LED_TYPE_WARM].flux);
+}
+
 // initial color/brightness table values setup
 void
 led_tables_init(void) {
@@ -322,6 +396,20 @@ led_tables_init(void) {
     for (i = 0; i < CCT_ARR_SIZE; i++) {
         pwm_table_w[i] = 0;
         pwm_table_c[i] = 0;
+        pwm_boost_w[i] = 0;
+        pwm_boost_c[i] = 0;
+    }
+    for (i = 0; i < 10; i++) {
+        bright_table_q8[i] = (int) ((BRIGHT_TABLE[i] * 256.0) + 0.5);
+    }
+    if (!lin_lut_build(&lin_cal[LED_TYPE_COLD], lin_lut[LED_TYPE_COLD], PWM_MAX) ||
+        !lin_lut_build(&lin_cal[LED_TYPE_WARM], lin_lut[LED_TYPE_WARM], PWM_MAX)) {
+        // fall back to no correction
+        printf("Error, LIN_DUTY and LIN_FLUX points must be increasing from 0 to %d\n", LIN_FULL);
+        for (i = 0; i <= PWM_MAX; i++) {
+            lin_lut[LED_TYPE_COLD][i] = i;
+            lin_lut[LED_TYPE_WARM][i] = i;
+        }
     }
 
     // build up table of PWM values for all color temperatures
@@ -336,6 +424,16 @@ led_tables_init(void) {
         dc_c = rdc * dc_w;
         pwm_table_w[i] = dc_w * PWM_MAX;
         pwm_table_c[i] = dc_c * PWM_MAX;
+        // boost: scale up so that the brighter-driven LED runs at 100% duty cycle.
+        // This is done from the duty cycle ratio, so that the LED CCT values
+        // (where rdc is 0 or infinite) are handled too
+        if (rdc <= 1.0) {
+            pwm_boost_w[i] = PWM_MAX;
+            pwm_boost_c[i] = (int) (rdc * PWM_MAX);
+        } else {
+            pwm_boost_w[i] = (int) (PWM_MAX / rdc);
+            pwm_boost_c[i] = PWM_MAX;
+        }
         // printf("%d:(%dW,%dC), ", i+cct_tbl_min_div100, pwm_table_w[i], pwm_table_c[i]);
     }
 
@@ -382,6 +480,20 @@ led_tables_init(void) {
     }
     printf("</tbl>\n");
     printf("\n");
+    printf("LED Boost Lookup Table:\n\n");
+    printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?><tbl>");
+    for (i = 0; i < CCT_ARR_SIZE; i++) {
+        if (pwm_boost_c[i]==0 && pwm_boost_w[i]==0) {
+            // skip unused entries
+            continue;
+        }
+        printf("<r K=\"%d\">", CCT[i]);
+        printf("<c>%d</c>", pwm_boost_c[i]);
+        printf("<w>%d</w>", pwm_boost_w[i]);
+        printf("</r>");
+    }
+    printf("</tbl>\n");
+    printf("\n");
 }
 
 // set the PWM level (0 to PWM_MAX) for the first or second lighting module
@@ -406,22 +518,187 @@ set_pwm_percent(char module, char ledtype, int percent) {
     pwm_set_chan_level(slice_num[module], ledtype, level); // set PWM value
 }
 
+// fill a zone of the strip back buffer, with a color temperature gradient from
+// col_start to col_end (both are color temperature / 100) at brightness bright (0-9, or -1 for off).
+// Everything is fixed point: the color temperature index is in Q8 (256 = 100 K) and
+// each pixel is interpolated between the two nearest PWM table entries.
+void
+strip_set_zone(int first, int count, int col_start, int col_end, int bright) {
+    int p;
+    int col_q8, col_step;
+    int i, j, f;
+    uint32_t bq8;
+    uint32_t level_w, level_c;
+    uint32_t *fb;
+    uint32_t status;
+    const int *tbl_w = boost ? pwm_boost_w : pwm_table_w;
+    const int *tbl_c = boost ? pwm_boost_c : pwm_table_c;
+
+    if (first < 0) {
+        count = count + first;
+        first = 0;
+    }
+    if (first + count > STRIP_NUM_PIXELS) {
+        count = STRIP_NUM_PIXELS - first;
+    }
+    if (count <= 0) {
+        return;
+    }
+    if (col_start < colmin) {
+        col_start = colmin;
+    } else if (col_start > colmax) {
+        col_start = colmax;
+    }
+    if (col_end < colmin) {
+        col_end = colmin;
+    } else if (col_end > colmax) {
+        col_end = colmax;
+    }
+    if (bright > 9) {
+        bright = 9;
+    } else if (bright < -1) {
+        bright = -1;
+    }
+
+    // the back buffer is drawn from both the main loop and the encoder interrupt, and is
+    // swapped by the strip interrupts, so it is drawn with interrupts disabled
+    status = save_and_disable_interrupts();
+    fb = &strip_fb[strip_back][first];
+    if (bright < 0) { // switch the zone off
+        for (p = 0; p < count; p++) {
+            fb[p] = 0;
+        }
+        restore_interrupts(status);
+        return;
+    }
+
+    bq8 = bright_table_q8[bright];
+    col_q8 = (col_start - cct_tbl_min_div100) * 256;
+    col_step = 0;
+    if (count > 1) {
+        col_step = ((col_end - col_start) * 256) / (count - 1);
+    }
+    for (p = 0; p < count; p++) {
+        i = col_q8 >> 8;
+        f = col_q8 & 0xff;
+        j = i + (f != 0); // don't read past the last entry when exactly on it
+        level_w = (tbl_w[i] * (256 - f) + tbl_w[j] * f) >> 8;
+        level_c = (tbl_c[i] * (256 - f) + tbl_c[j] * f) >> 8;
+        // scale by brightness (Q8) and convert from PWM level to 8-bit (Q12)
+        level_w = (level_w * bq8 * STRIP_K) >> 20;
+        level_c = (level_c * bq8 * STRIP_K) >> 20;
+        fb[p] = (level_c << STRIP_SHIFT_COLD) | (level_w << STRIP_SHIFT_WARM);
+        col_q8 = col_q8 + col_step;
+    }
+    restore_interrupts(status);
+}
+
+// start sending the back buffer, and swap buffers.
+// Must be called with interrupts disabled, or from the strip interrupts
+void
+strip_kick(void) {
+    dma_channel_transfer_from_buffer_now(strip_dma_chan, strip_fb[strip_back], STRIP_NUM_PIXELS);
+    strip_back ^= 1;
+    // carry the frame over, so that zones which are not redrawn keep their contents
+    memcpy(strip_fb[strip_back], strip_fb[strip_back ^ 1], sizeof(strip_fb[0]));
+    strip_pending = false;
+    strip_busy = true;
+}
+
+// called once the previous frame has been clocked out and latched by the strip.
+// If another frame was requested in the meantime, it is sent straight away
+int64_t
+strip_latch_cb(alarm_id_t id, void *user_data) {
+    strip_busy = false;
+    if (strip_pending) {
+        strip_kick();
+    }
+    return 0;
+}
+
+// DMA has finished feeding the PIO; wait for the FIFO to drain and for the reset time
+void
+strip_dma_handler(void) {
+    dma_channel_acknowledge_irq0(strip_dma_chan);
+    if (add_alarm_in_us(STRIP_DRAIN_US + STRIP_RESET_US, strip_latch_cb, NULL, true) < 0) {
+        // no alarm slots left; don't let the strip stall
+        strip_busy = false;
+    }
+}
+
+// send the back buffer to the strip. DMA feeds the PIO state machine, so the CPU is
+// free while the frame is clocked out. This never waits; if a frame is still being sent,
+// the new one follows it as soon as it has latched. Can be called from any context.
+void
+strip_show(void) {
+    uint32_t status;
+
+    status = save_and_disable_interrupts();
+    strip_pending = true;
+    if (!strip_busy) {
+        strip_kick();
+    }
+    restore_interrupts(status);
+}
+
+// fill the whole strip for the given color temperature and brightness
+// (or with a gradient across the supported color temperatures, if strip_gradient is set)
+void
+strip_update(int col, int bright) {
+    if (strip_gradient) {
+        strip_set_zone(0, STRIP_NUM_PIXELS, colmin, colmax, bright);
+    } else {
+        strip_set_zone(0, STRIP_NUM_PIXELS, col, col, bright);
+    }
+    strip_show();
+}
+
+// set up the PIO state machine and the DMA channel that feeds it
+void
+strip_init(void) {
+    uint offset;
+    dma_channel_config dc;
+
+    offset = pio_add_program(strip_pio, &strip_program);
+    strip_sm = pio_claim_unused_sm(strip_pio, true);
+    strip_program_init(strip_pio, strip_sm, offset, STRIP_PIN, STRIP_FREQ, STRIP_BITS);
+
+    strip_dma_chan = dma_claim_unused_channel(true);
+    dc = dma_channel_get_default_config(strip_dma_chan);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(strip_pio, strip_sm, true));
+    dma_channel_configure(strip_dma_chan, &dc, &strip_pio->txf[strip_sm], strip_fb[0], STRIP_NUM_PIXELS, false);
+
+    // the next frame is started from the DMA completion interrupt
+    dma_channel_set_irq0_enabled(strip_dma_chan, true);
+    irq_set_exclusive_handler(DMA_IRQ_0, strip_dma_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
 // sets the PWM for the warm and cold LEDs
 // col is the desired color temperature / 100
 // bright is the brightness in the range 0-9 (-1 sets it completely off)
 void
 set_lighting(char module, int col, int bright) {
     double level_w, level_c;
+    const int *tbl_w = boost ? pwm_boost_w : pwm_table_w;
+    const int *tbl_c = boost ? pwm_boost_c : pwm_table_c;
     if (bright >= 0) {
-        level_w = BRIGHT_TABLE[bright] * (double) pwm_table_w[col - cct_tbl_min_div100];
-        level_c = BRIGHT_TABLE[bright] * (double) pwm_table_c[col - cct_tbl_min_div100];
-        set_pwm_level(module, LED_TYPE_WARM, (int) (level_w));
-        set_pwm_level(module, LED_TYPE_COLD, (int) (level_c));
+        level_w = BRIGHT_TABLE[bright] * (double) tbl_w[col - cct_tbl_min_div100];
+        level_c = BRIGHT_TABLE[bright] * (double) tbl_c[col - cct_tbl_min_div100];
+        // levels are linear in flux (and never above PWM_MAX), lin_lut converts them to duty cycle
+        set_pwm_level(module, LED_TYPE_WARM, lin_lut[LED_TYPE_WARM][(int) (level_w)]);
+        set_pwm_level(module, LED_TYPE_COLD, lin_lut[LED_TYPE_COLD][(int) (level_c)]);
         printf("pwm (cold,warm) (%d,%d)\n", (int) level_c, (int) level_w);
     } else { // switch LEDs off
         set_pwm_level(module, LED_TYPE_WARM, 0);
         set_pwm_level(module, LED_TYPE_COLD, 0);
     }
+    if (module == 0) { // the strip follows the first lighting module
+        strip_update(col, bright);
+    }
 }
 
 // handle input events (mainly rotary encoder).
@@ -439,6 +716,9 @@ void input_cb(uint gpio, uint32_t events) {
     enc_val = ENC_VAL;
     enc_state = (enc_val << 2) | old_enc_val;
     old_enc_val = enc_val;
+    if (calibrating) { // the raw duty cycle being measured must not be overwritten
+        return;
+    }
     switch (enc_state) {
         case 0x1:
         case 0x7:
@@ -504,6 +784,9 @@ board_init(void) {
     gpio_set_function(COLD_PIN_1, GPIO_FUNC_PWM);
     gpio_set_function(WARM_PIN_1, GPIO_FUNC_PWM);
 
+    // addressable LED strip output
+    strip_init();
+
     slice_num[0] = pwm_gpio_to_slice_num(COLD_PIN_0);
     slice_num[1] = pwm_gpio_to_slice_num(COLD_PIN_1);
 
@@ -563,17 +846,33 @@ board_init(void) {
     gpio_set_irq_enabled(BUTTON_PIN, GPIO_IRQ_LEVEL_LOW, true);
 }
 
+// switch between the constant-brightness and the boost (maximum output) tables.
+// Both are precomputed, so only the PWM registers need updating
+void toggle_boost(void) {
+    boost = !boost;
+    printf("\nboost %s\n", boost ? "on" : "off");
+    set_lighting(0, color, intensity);
+}
+
 void do_debounce(void) {
     if (bmenu_state == BMENU_PRESSED) {
         bmenu_state = BMENU_DEBOUNCING;
         debounce_count = 5;
+        hold_count = 0;
     } else if (debounce_count > 0) {
         debounce_count--;
         if (debounce_count <= 0) {
             if (BUTTON_UNPRESSED) {
                 bmenu_state = BMENU_IDLE;
+                gpio_set_irq_enabled(BUTTON_PIN, GPIO_IRQ_LEVEL_LOW, true);
             } else {
                 debounce_count = 5;
+                hold_count++;
+                if (hold_count == BOOST_HOLD_COUNT) {
+                    // long press: undo the mode change from the initial press, and toggle boost
+                    toggle_appmode();
+                    toggle_boost();
+                }
             }
         }
     }
@@ -586,7 +885,123 @@ display_keypress_list(void) {
     printf("b   - cycle through brightness settings\n");
     printf("c/d - increase/decrease color temperature (colder/warmer)\n");
     printf("q/a - increase/decrease cold PWM by 5 percent\n");
-    printf("w/s - increase/decrease warm PWM by 5 percent\n\n");
+    printf("w/s - increase/decrease warm PWM by 5 percent\n");
+    printf("x   - toggle boost (maximum output) mode, or hold the button down\n");
+    printf("g   - toggle color temperature gradient on the LED strip\n");
+    printf("l   - enter PWM-to-flux linearization calibration points\n\n");
+}
+
+// read a line of text from the serial console (blocking), echoing the characters
+void
+read_line(char *buf, int len) {
+    int c;
+    int i = 0;
+    while (FOREVER) {
+        c = getchar_timeout_us(1000);
+        if (c == PICO_ERROR_TIMEOUT) {
+            continue;
+        }
+        if (c == '\r' || c == '\n') {
+            break;
+        }
+        if ((c == '\b' || c == 0x7f) && i > 0) {
+            i--;
+            printf("\b \b");
+        } else if (c >= ' ' && i < len - 1) {
+            buf[i++] = (char) c;
+            putchar(c);
+        }
+    }
+    buf[i] = '\0';
+    printf("\n");
+}
+
+// linearization calibration. For each LED type, the user sets the raw duty cycle of a
+// calibration point, measures the flux relative to full duty, and enters it.
+// The duty cycle of a point can also be moved, e.g. to follow a turn-on threshold
+void
+lin_calibrate(void) {
+    char buf[32];
+    char t;
+    int pt, val, n;
+    bool set_duty;
+    char ledtype;
+    lin_cal_t *cal;
+    lin_cal_t applied[2]; // the points that the linearization tables were last built from
+
+    calibrating = true;
+    applied[LED_TYPE_COLD] = lin_cal[LED_TYPE_COLD];
+    applied[LED_TYPE_WARM] = lin_cal[LED_TYPE_WARM];
+
+    printf("\nlinearization calibration points (per-mille duty, and flux at that duty):\n");
+    lin_cal_print();
+    printf("'<c|w> <point 1-%d>' sets the point's duty cycle for measuring\n", LIN_CAL_POINTS - 1);
+    printf("'<c|w> <point 1-%d> d <duty>' moves the point to another duty cycle, and sets it\n",
+           LIN_CAL_POINTS - 2);
+    printf("'<c|w> <point 1-%d> <flux 1-%d>' stores a measurement. Empty line to finish.\n",
+           LIN_CAL_POINTS - 2, LIN_FULL - 1);
+    while (FOREVER) {
+        printf("> ");
+        read_line(buf, sizeof(buf));
+        n = sscanf(buf, " %c %d d %d", &t, &pt, &val);
+        set_duty = (n == 3);
+        if (!set_duty) {
+            n = sscanf(buf, " %c %d %d", &t, &pt, &val);
+        }
+        if (n <= 0) {
+            break;
+        }
+        // the first and last points (0 and full duty) are fixed. The last one is the
+        // flux reference, and can only be set for measuring
+        if ((t != 'c' && t != 'w') || n < 2 || pt < 1 || pt > LIN_CAL_POINTS - 1 ||
+            (n == 3 && pt > LIN_CAL_POINTS - 2)) {
+            printf("invalid entry\n");
+            continue;
+        }
+        ledtype = (t == 'c') ? LED_TYPE_COLD : LED_TYPE_WARM;
+        cal = &lin_cal[ledtype];
+        if (set_duty) {
+            if (val <= cal->duty[pt - 1] || val >= cal->duty[pt + 1]) {
+                printf("duty must be between the neighbouring points (%d-%d)\n",
+                       cal->duty[pt - 1] + 1, cal->duty[pt + 1] - 1);
+                continue;
+            }
+            cal->duty[pt] = val;
+        }
+        if (n == 2 || set_duty) { // set the raw duty cycle of the calibration point, with the other LED type off
+            set_pwm_level(0, ledtype, ((cal->duty[pt] * PWM_MAX) + (LIN_FULL / 2)) / LIN_FULL);
+            set_pwm_level(0, ledtype == LED_TYPE_COLD ? LED_TYPE_WARM : LED_TYPE_COLD, 0);
+            printf("[0][%s] = point %d (%d per-mille), measure flux relative to full duty\n",
+                   t == 'c' ? "COLD" : "WARM", pt, cal->duty[pt]);
+            if (!set_duty) {
+                continue;
+            }
+        } else {
+            if (val < 1 || val > LIN_FULL - 1) {
+                printf("flux must be 1-%d\n", LIN_FULL - 1);
+                continue;
+            }
+            // the entry is kept even if the points are not increasing yet,
+            // so that the points can be entered in any order
+            cal->flux[pt] = val;
+        }
+        if (lin_lut_build(cal, lin_lut[ledtype], PWM_MAX)) {
+            applied[ledtype] = *cal;
+            lin_cal_print();
+        } else {
+            printf("points must be increasing, not applied yet\n");
+        }
+    }
+    // any points that could not be applied are put back to match the tables
+    if (!lin_lut_build(&lin_cal[LED_TYPE_COLD], lin_lut[LED_TYPE_COLD], PWM_MAX) ||
+        !lin_lut_build(&lin_cal[LED_TYPE_WARM], lin_lut[LED_TYPE_WARM], PWM_MAX)) {
+        lin_cal[LED_TYPE_COLD] = applied[LED_TYPE_COLD];
+        lin_cal[LED_TYPE_WARM] = applied[LED_TYPE_WARM];
+        printf("warning, points are not increasing, restored the last points that were applied:\n");
+        lin_cal_print();
+    }
+    calibrating = false;
+    set_lighting(0, color, intensity);
 }
 
 void
@@ -675,6 +1090,17 @@ check_for_keypress_input(void) {
             printf("[0][WARM] = %d percent\n", pwmlevel);
             set_pwm_percent(0, LED_TYPE_WARM, pwmlevel);
             break;
+        case 'x':
+            toggle_boost();
+            break;
+        case 'l':
+            lin_calibrate();
+            break;
+        case 'g':
+            strip_gradient = !strip_gradient;
+            printf("\nstrip gradient %s\n", strip_gradient ? "on" : "off");
+            set_lighting(0, color, intensity);
+            break;
         default:
             break;
     }
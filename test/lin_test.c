@@ -0,0 +1,121 @@
+/************************************************************************
+ * picochroma - A digital lighting system built with Pi Pico
+ * lin_test.c
+ * host test for the PWM-to-flux linearization table
+ ************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lin.h"
+
+// same as PWM_MAX in main.c
+#define LEVEL_MAX 3048
+#define DUTY_DEFAULT {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 1000}
+
+uint16_t lut[LEVEL_MAX + 1];
+int failures = 0;
+
+// the flux level (0 to LEVEL_MAX) for a duty cycle level, using the same piecewise-linear
+// model as the calibration points, rounded to the nearest level
+int
+flux_of_duty(const lin_cal_t *cal, int duty) {
+    int k = 0;
+    double x, f;
+    x = ((double) duty * LIN_FULL) / LEVEL_MAX; // per-mille duty
+    while ((k < LIN_CAL_POINTS - 2) && (cal->duty[k + 1] < x)) {
+        k++;
+    }
+    f = cal->flux[k] + (((double) (cal->flux[k + 1] - cal->flux[k]) * (x - cal->duty[k])) /
+                        (cal->duty[k + 1] - cal->duty[k]));
+    return (int) (((f * LEVEL_MAX) / LIN_FULL) + 0.5);
+}
+
+void
+check(bool ok, const char *name) {
+    if (!ok) {
+        printf("FAIL: %s\n", name);
+        failures++;
+    }
+}
+
+void
+test_identity(void) {
+    const lin_cal_t cal = {LIN_DUTY_C, LIN_FLUX_C};
+    int i;
+    bool ok = true;
+    check(lin_lut_build(&cal, lut, LEVEL_MAX), "default points are accepted");
+    for (i = 0; i <= LEVEL_MAX; i++) {
+        if (lut[i] != i) {
+            ok = false;
+        }
+    }
+    check(ok, "default points give an identity table");
+}
+
+// checks that the table is monotonic, covers the full range, and that converting
+// back to flux is within 1 level
+void
+test_points(const lin_cal_t *cal, const char *name) {
+    int i, err;
+    int maxerr = 0;
+    bool mono = true;
+    check(lin_lut_build(cal, lut, LEVEL_MAX), name);
+    for (i = 1; i <= LEVEL_MAX; i++) {
+        if (lut[i] < lut[i - 1]) {
+            mono = false;
+        }
+    }
+    for (i = 0; i <= LEVEL_MAX; i++) {
+        err = abs(flux_of_duty(cal, lut[i]) - i);
+        if (err > maxerr) {
+            maxerr = err;
+        }
+    }
+    check(mono, "table is monotonic");
+    check(lut[0] == 0 && lut[LEVEL_MAX] == LEVEL_MAX, "table covers the full range");
+    check(maxerr <= 1, "round-trip error is at most 1 level");
+    printf("%s: max round-trip error %d\n", name, maxerr);
+}
+
+void
+test_rejected(void) {
+    const lin_cal_t dip = {DUTY_DEFAULT, {0, 5, 15, 40, 100, 250, 500, 450, 900, 960, 990, 1000}};
+    const lin_cal_t flat = {DUTY_DEFAULT, {0, 5, 15, 40, 100, 250, 500, 500, 900, 960, 990, 1000}};
+    const lin_cal_t scale = {DUTY_DEFAULT, {0, 5, 15, 40, 100, 250, 500, 750, 900, 960, 990, 999}};
+    const lin_cal_t duty = {{0, 5, 15, 40, 100, 250, 500, 750, 900, 990, 960, 1000}, DUTY_DEFAULT};
+    lut[1] = 1234;
+    check(!lin_lut_build(&dip, lut, LEVEL_MAX), "decreasing flux is rejected");
+    check(!lin_lut_build(&flat, lut, LEVEL_MAX), "flat flux is rejected");
+    check(!lin_lut_build(&scale, lut, LEVEL_MAX), "last point must be full flux");
+    check(!lin_lut_build(&duty, lut, LEVEL_MAX), "decreasing duty is rejected");
+    check(lut[1] == 1234, "table is unchanged when rejected");
+}
+
+int
+main(void) {
+    // these stay below 2 flux levels per duty level, so that 1 level of
+    // round-trip error is achievable with integer duty
+    // turn-on threshold near zero
+    const lin_cal_t knee = {DUTY_DEFAULT, {0, 1, 5, 25, 80, 230, 490, 750, 905, 963, 991, 1000}};
+    // compression near full duty
+    const lin_cal_t comp = {DUTY_DEFAULT, {0, 2, 8, 30, 90, 260, 560, 820, 940, 980, 995, 1000}};
+    // fast start near zero
+    const lin_cal_t fast = {DUTY_DEFAULT, {0, 10, 30, 80, 180, 380, 640, 850, 950, 985, 997, 1000}};
+    // moved duty positions, with a dead zone below 2%
+    const lin_cal_t moved = {{0, 20, 30, 50, 100, 250, 500, 750, 900, 960, 990, 1000},
+                             {0, 1, 15, 50, 110, 260, 510, 755, 902, 961, 990, 1000}};
+
+    test_identity();
+    test_points(&knee, "knee points");
+    test_points(&comp, "compression points");
+    test_points(&fast, "fast start points");
+    test_points(&moved, "moved points");
+    test_rejected();
+
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}